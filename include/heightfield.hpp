@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include "glm/glm.hpp"
+
+#include "mesh.hpp"
+
+// Read-only query structure over a terrain grid built by Perlin::getMesh.
+// Heights are interpolated bilinearly inside each grid cell. A min/max
+// mipmap over the cells lets raycasts skip whole regions that the ray
+// passes above without touching the individual samples.
+//
+// All queries are const and touch no shared mutable state, so a single
+// HeightField can be queried from any number of threads at once.
+class HeightField {
+public:
+    HeightField() = default;
+
+    // Builds the field from a grid mesh of width*height vertices
+    // (the layout produced by Perlin::getMesh)
+    HeightField(const Mesh& mesh, int width, int height);
+
+    bool empty() const { return heights_.empty(); }
+
+    // Global extremes of the terrain, O(1)
+    float minHeight() const { return min_height_; }
+    float maxHeight() const { return max_height_; }
+
+    // Bilinear height at world (x, z); points outside the grid are
+    // clamped to the nearest border (NaN coordinates to the first row/column)
+    float heightAt(float x, float z) const;
+
+    // Surface normal at world (x, z), from the bilinear gradient; flat
+    // along any axis on which the point lies outside the grid
+    glm::vec3 normalAt(float x, float z) const;
+
+    // Batched heightAt: out[i] = heightAt(points[i].x, points[i].y)
+    void heightsAt(const std::vector<glm::vec2>& points,
+        std::vector<float>& out) const;
+
+    // Casts the ray origin + t * dir for t in [0, max_distance] (in units
+    // of |dir|). The terrain is treated as solid below its surface within
+    // the grid footprint: if the ray starts on or under the surface, or
+    // enters the footprint through a border under the edge height, the hit
+    // is at that point. Otherwise the hit is the first crossing of the
+    // surface from above. Heights within a small tolerance of the surface
+    // count as on it. A zero-length dir never hits. On hit, writes the
+    // world-space point to hit and the ray parameter to hit_t.
+    bool raycast(const glm::vec3& origin,
+        const glm::vec3& dir,
+        float max_distance,
+        glm::vec3& hit,
+        float& hit_t) const;
+
+private:
+    int   cols_ = 0;          // vertices along x
+    int   rows_ = 0;          // vertices along z
+    float origin_x_ = 0.0f;   // world x of column 0
+    float origin_z_ = 0.0f;   // world z of row 0
+    float spacing_x_ = 1.0f;  // world distance between columns
+    float spacing_z_ = 1.0f;  // world distance between rows
+    float min_height_ = 0.0f;
+    float max_height_ = 0.0f;
+    float surface_epsilon_ = 0.0f; // "on the surface" tolerance for raycasts
+
+    std::vector<float> heights_; // rows_ * cols_, row-major
+
+    // Level 0 holds the (min, max) height of every grid cell, level k
+    // covers 2^k x 2^k cells; the last level is a single cell
+    struct MinMaxLevel {
+        int cols = 0;
+        int rows = 0;
+        std::vector<glm::vec2> bounds; // (min, max)
+    };
+    std::vector<MinMaxLevel> levels_;
+
+    void buildMinMax();
+
+    // heightAt in grid space (u along columns, v along rows)
+    float heightAtGrid(float u, float v) const;
+
+    inline float sample(int r, int c) const {
+        return heights_[r * cols_ + c];
+    }
+
+    // Clamps a grid coordinate to [0, high], sending NaN to 0
+    static inline float clampGrid(float u, float high) {
+        if (!(u > 0.0f)) return 0.0f;
+        return u < high ? u : high;
+    }
+
+    // Ray / bilinear patch test inside level 0 cell (r, c), in grid space,
+    // for s in [s_begin, s_end]; expects the ray to be above the surface
+    // before s_begin and reports where it first reaches it
+    bool intersectCell(int r, int c,
+        const glm::dvec3& o, const glm::dvec3& d,
+        double s_begin, double s_end, double& s_hit) const;
+};
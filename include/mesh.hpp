@@ -0,0 +1,9 @@
+#pragma once
+#include <vector>
+#include "glm/glm.hpp"
+
+struct Mesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<unsigned int> indices;
+};
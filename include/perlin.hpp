@@ -10,6 +10,8 @@
 #include "glm/glm.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
+#include "mesh.hpp"
+
 struct GLMesh {
     GLuint vao = 0;
     GLuint vbo = 0;   // vertex buffer
@@ -18,12 +20,6 @@ struct GLMesh {
     GLsizei indexCount = 0;
 };
 
-struct Mesh {
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec3> normals;
-    std::vector<unsigned int> indices;
-};
-
 class Perlin {
 public:
     explicit Perlin(uint64_t seed, double phase = 0.0);
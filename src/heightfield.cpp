@@ -0,0 +1,308 @@
+#include "heightfield.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+HeightField::HeightField(const Mesh& mesh, int width, int height) {
+    if (width <= 1 || height <= 1) return;
+    if ((int)mesh.vertices.size() < width * height) return;
+
+    cols_ = width;
+    rows_ = height;
+
+    origin_x_ = mesh.vertices[0].x;
+    origin_z_ = mesh.vertices[0].z;
+
+    // getMesh places vertices one unit apart, but don't rely on it
+    spacing_x_ = mesh.vertices[1].x - mesh.vertices[0].x;
+    spacing_z_ = mesh.vertices[cols_].z - mesh.vertices[0].z;
+    if (spacing_x_ == 0.0f) spacing_x_ = 1.0f;
+    if (spacing_z_ == 0.0f) spacing_z_ = 1.0f;
+
+    heights_.resize(rows_ * cols_);
+    for (int i = 0; i < rows_ * cols_; ++i)
+        heights_[i] = mesh.vertices[i].y;
+
+    buildMinMax();
+}
+
+void HeightField::buildMinMax() {
+    MinMaxLevel base;
+    base.cols = cols_ - 1;
+    base.rows = rows_ - 1;
+    base.bounds.resize(base.cols * base.rows);
+
+    for (int r = 0; r < base.rows; ++r) {
+        for (int c = 0; c < base.cols; ++c) {
+            float h00 = sample(r, c);
+            float h10 = sample(r, c + 1);
+            float h01 = sample(r + 1, c);
+            float h11 = sample(r + 1, c + 1);
+            // a bilinear patch never leaves the range of its corners
+            base.bounds[r * base.cols + c] = glm::vec2(
+                std::min(std::min(h00, h10), std::min(h01, h11)),
+                std::max(std::max(h00, h10), std::max(h01, h11)));
+        }
+    }
+    levels_.push_back(std::move(base));
+
+    while (levels_.back().cols > 1 || levels_.back().rows > 1) {
+        const MinMaxLevel& child = levels_.back();
+        MinMaxLevel parent;
+        parent.cols = (child.cols + 1) / 2;
+        parent.rows = (child.rows + 1) / 2;
+        parent.bounds.resize(parent.cols * parent.rows);
+
+        for (int r = 0; r < parent.rows; ++r) {
+            for (int c = 0; c < parent.cols; ++c) {
+                glm::vec2 b(std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::lowest());
+                for (int cr = 2 * r; cr < std::min(2 * r + 2, child.rows); ++cr) {
+                    for (int cc = 2 * c; cc < std::min(2 * c + 2, child.cols); ++cc) {
+                        const glm::vec2& cb = child.bounds[cr * child.cols + cc];
+                        b.x = std::min(b.x, cb.x);
+                        b.y = std::max(b.y, cb.y);
+                    }
+                }
+                parent.bounds[r * parent.cols + c] = b;
+            }
+        }
+        levels_.push_back(std::move(parent));
+    }
+
+    min_height_ = levels_.back().bounds[0].x;
+    max_height_ = levels_.back().bounds[0].y;
+
+    // a few float ulps at the largest height, so a ray started exactly at
+    // heightAt() still counts as touching the surface
+    surface_epsilon_ = 1e-5f * std::max(1.0f,
+        std::max(std::abs(min_height_), std::abs(max_height_)));
+}
+
+float HeightField::heightAt(float x, float z) const {
+    if (empty()) return 0.0f;
+
+    return heightAtGrid((x - origin_x_) / spacing_x_, (z - origin_z_) / spacing_z_);
+}
+
+float HeightField::heightAtGrid(float u, float v) const {
+    u = clampGrid(u, float(cols_ - 1));
+    v = clampGrid(v, float(rows_ - 1));
+
+    int c = std::min((int)u, cols_ - 2);
+    int r = std::min((int)v, rows_ - 2);
+    float fu = u - c;
+    float fv = v - r;
+
+    float bottom = sample(r, c) + (sample(r, c + 1) - sample(r, c)) * fu;
+    float top    = sample(r + 1, c) + (sample(r + 1, c + 1) - sample(r + 1, c)) * fu;
+    return bottom + (top - bottom) * fv;
+}
+
+glm::vec3 HeightField::normalAt(float x, float z) const {
+    if (empty()) return glm::vec3(0.0f, 1.0f, 0.0f);
+
+    float raw_u = (x - origin_x_) / spacing_x_;
+    float raw_v = (z - origin_z_) / spacing_z_;
+    float u = clampGrid(raw_u, float(cols_ - 1));
+    float v = clampGrid(raw_v, float(rows_ - 1));
+
+    int c = std::min((int)u, cols_ - 2);
+    int r = std::min((int)v, rows_ - 2);
+    float fu = u - c;
+    float fv = v - r;
+
+    float h00 = sample(r, c);
+    float h10 = sample(r, c + 1);
+    float h01 = sample(r + 1, c);
+    float h11 = sample(r + 1, c + 1);
+    float k = h00 - h10 - h01 + h11;
+
+    float dh_dx = ((h10 - h00) + k * fv) / spacing_x_;
+    float dh_dz = ((h01 - h00) + k * fu) / spacing_z_;
+
+    // heightAt is constant along a clamped axis, so the slope there is zero
+    if (u != raw_u) dh_dx = 0.0f;
+    if (v != raw_v) dh_dz = 0.0f;
+
+    return glm::normalize(glm::vec3(-dh_dx, 1.0f, -dh_dz));
+}
+
+void HeightField::heightsAt(const std::vector<glm::vec2>& points, std::vector<float>& out) const {
+    if (out.size() != points.size()) out.resize(points.size());
+
+    for (size_t i = 0; i < points.size(); ++i)
+        out[i] = heightAt(points[i].x, points[i].y);
+}
+
+bool HeightField::intersectCell(int r, int c,
+    const glm::dvec3& o, const glm::dvec3& d,
+    double s_begin, double s_end, double& s_hit) const
+{
+    double h00 = sample(r, c);
+    double h10 = sample(r, c + 1);
+    double h01 = sample(r + 1, c);
+    double h11 = sample(r + 1, c + 1);
+    double e = h10 - h00;
+    double g = h01 - h00;
+    double k = h00 - h10 - h01 + h11;
+
+    // cell-local ray start, re-based at s_begin for precision
+    double au = o.x + d.x * s_begin - c;
+    double av = o.z + d.z * s_begin - r;
+    double ay = o.y + d.y * s_begin;
+    double len = s_end - s_begin;
+
+    // surface height minus ray height along the ray: A s^2 + B s + C
+    double A = k * d.x * d.z;
+    double B = e * d.x + g * d.z + k * (au * d.z + av * d.x) - d.y;
+    double C = h00 + e * au + g * av + k * au * av - ay;
+
+    // already touching the surface where the ray enters the cell
+    if (C >= -surface_epsilon_) {
+        s_hit = s_begin;
+        return true;
+    }
+
+    // C < 0 here, so the smallest root in range is where the ray comes
+    // down onto the surface
+    const double tolerance = 1e-9;
+    double root = std::numeric_limits<double>::infinity();
+
+    if (std::abs(A) < 1e-12) {
+        if (std::abs(B) > 1e-12) root = -C / B;
+    } else {
+        double disc = B * B - 4.0 * A * C;
+        if (disc < 0.0) return false;
+        // numerically stable form of the quadratic formula
+        double q = -0.5 * (B + std::copysign(std::sqrt(disc), B));
+        double r1 = q / A;
+        double r2 = (q != 0.0) ? C / q : r1;
+        if (r1 > r2) std::swap(r1, r2);
+        root = (r1 >= -tolerance) ? r1 : r2;
+    }
+
+    if (root < -tolerance || root > len + tolerance) return false;
+
+    s_hit = s_begin + std::clamp(root, 0.0, len);
+    return true;
+}
+
+bool HeightField::raycast(const glm::vec3& origin,
+    const glm::vec3& dir,
+    float max_distance,
+    glm::vec3& hit,
+    float& hit_t) const
+{
+    if (empty()) return false;
+    if (!std::isfinite(origin.x) || !std::isfinite(origin.y) || !std::isfinite(origin.z)) return false;
+    if (!std::isfinite(dir.x) || !std::isfinite(dir.y) || !std::isfinite(dir.z)) return false;
+    if (!(max_distance >= 0.0f)) return false;
+
+    // grid space: x and z in cell units, y untouched. The direction is
+    // normalized there so the tolerances below don't depend on |dir|;
+    // t is rescaled back to units of |dir| on return.
+    glm::dvec3 o((origin.x - origin_x_) / spacing_x_, origin.y, (origin.z - origin_z_) / spacing_z_);
+    glm::dvec3 d((double)dir.x / spacing_x_, dir.y, (double)dir.z / spacing_z_);
+
+    double dir_length = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+    if (!(dir_length > 0.0) || !std::isfinite(dir_length)) return false;
+    d = d * (1.0 / dir_length);
+
+    // clip the ray against the grid footprint, then the height range
+    double t_enter = 0.0;
+    double t_exit  = max_distance * dir_length;
+    const double box_min[3] = { 0.0, min_height_, 0.0 };
+    const double box_max[3] = { double(cols_ - 1), max_height_, double(rows_ - 1) };
+
+    for (int axis = 0; axis < 3; axis += 2) {
+        if (d[axis] == 0.0) {
+            if (o[axis] < box_min[axis] || o[axis] > box_max[axis]) return false;
+            continue;
+        }
+        double t0 = (box_min[axis] - o[axis]) / d[axis];
+        double t1 = (box_max[axis] - o[axis]) / d[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        t_enter = std::max(t_enter, t0);
+        t_exit  = std::min(t_exit, t1);
+    }
+    if (t_enter > t_exit) return false;
+
+    // starting inside the terrain, or coming in through a border below it
+    glm::dvec3 entry = o + d * t_enter;
+    if (entry.y <= heightAtGrid((float)entry.x, (float)entry.z) + surface_epsilon_) {
+        hit_t = (float)(t_enter / dir_length);
+        hit = origin + dir * hit_t;
+        return true;
+    }
+
+    // from here on the ray is above the surface until it hits it, so it
+    // can only hit once it has come down to max_height_
+    if (d.y == 0.0) {
+        if (o.y > max_height_) return false;
+    } else {
+        double t0 = (min_height_ - o.y) / d.y;
+        double t1 = (max_height_ - o.y) / d.y;
+        if (t0 > t1) std::swap(t0, t1);
+        t_enter = std::max(t_enter, t0);
+        t_exit  = std::min(t_exit, t1);
+    }
+    if (t_enter > t_exit) return false;
+
+    // small step in t that moves the ray ~1e-6 cells, used to pick the
+    // cell the ray is heading into when it sits exactly on a boundary
+    double horizontal = std::max(std::abs(d.x), std::abs(d.z));
+    double t_nudge = (horizontal > 0.0) ? 1e-6 / horizontal : 0.0;
+
+    const int top = (int)levels_.size() - 1;
+    int level = top;
+    double t = t_enter;
+
+    while (t <= t_exit) {
+        const MinMaxLevel& lvl = levels_[level];
+        const int size = 1 << level;
+
+        glm::dvec3 p = o + d * (t + t_nudge);
+        int cx = std::clamp((int)std::floor(p.x / size), 0, lvl.cols - 1);
+        int cz = std::clamp((int)std::floor(p.z / size), 0, lvl.rows - 1);
+
+        // extent of this cell in level 0 cell units
+        double u_min = double(cx * size);
+        double v_min = double(cz * size);
+        double u_max = double(std::min((cx + 1) * size, cols_ - 1));
+        double v_max = double(std::min((cz + 1) * size, rows_ - 1));
+
+        double t_cell_exit = t_exit;
+        if (d.x > 0.0) t_cell_exit = std::min(t_cell_exit, (u_max - o.x) / d.x);
+        if (d.x < 0.0) t_cell_exit = std::min(t_cell_exit, (u_min - o.x) / d.x);
+        if (d.z > 0.0) t_cell_exit = std::min(t_cell_exit, (v_max - o.z) / d.z);
+        if (d.z < 0.0) t_cell_exit = std::min(t_cell_exit, (v_min - o.z) / d.z);
+
+        // the ray is above the surface on entry, so it can only reach it
+        // here if it dips to the highest point of the cell
+        double y_low = std::min(o.y + d.y * t, o.y + d.y * t_cell_exit);
+        const glm::vec2& b = lvl.bounds[cz * lvl.cols + cx];
+        bool reaches = y_low <= b.y + surface_epsilon_;
+
+        if (reaches && level > 0) {
+            --level;
+            continue;
+        }
+
+        if (reaches) {
+            double s_hit;
+            if (intersectCell(cz, cx, o, d, t, t_cell_exit, s_hit)) {
+                hit_t = (float)(s_hit / dir_length);
+                hit = origin + dir * hit_t;
+                return true;
+            }
+        }
+
+        if (t_cell_exit >= t_exit) break;
+        t = std::max(t_cell_exit, t + t_nudge);
+        level = std::min(level + 1, top);
+    }
+
+    return false;
+}
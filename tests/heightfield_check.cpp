@@ -0,0 +1,231 @@
+// Standalone check of HeightField against brute-force ray marching.
+// Build from the repository root, with GLM on the include path:
+//
+//   g++ -O2 -std=c++17 -Iinclude tests/heightfield_check.cpp src/heightfield.cpp -o heightfield_check -pthread
+//
+// Exits non-zero if any query disagrees with the reference; also prints
+// single- and multi-threaded raycast throughput.
+
+#include "heightfield.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what) {
+    if (!ok) {
+        ++failures;
+        std::printf("FAIL: %s\n", what);
+    }
+}
+
+// Same vertex layout as Perlin::getMesh: one unit apart, centred on the origin
+static Mesh makeGrid(int width, int height) {
+    Mesh mesh;
+    for (int r = 0; r < height; ++r) {
+        for (int c = 0; c < width; ++c) {
+            float x = float(c - ((width - 1) / 2));
+            float z = float(r - ((height - 1) / 2));
+            float y = 6.0f * std::sin(x * 0.45f) * std::cos(z * 0.3f) + 2.0f * std::sin(x * z * 0.05f) + 10.0f;
+            mesh.vertices.push_back(glm::vec3(x, y, z));
+        }
+    }
+    return mesh;
+}
+
+struct Grid {
+    const HeightField& field;
+    float x_min, x_max, z_min, z_max;
+
+    bool inside(const glm::vec3& p) const {
+        return p.x >= x_min && p.x <= x_max && p.z >= z_min && p.z <= z_max;
+    }
+};
+
+// Reference: first sample that lies within the footprint on or under the surface
+static bool marchRay(const Grid& grid, const glm::vec3& o, const glm::vec3& d,
+    float max_distance, float step, float& t_hit)
+{
+    for (int i = 0; ; ++i) {
+        float t = std::min(i * step, max_distance);
+        glm::vec3 p = o + d * t;
+        if (grid.inside(p) && p.y <= grid.field.heightAt(p.x, p.z) + 1e-4f) {
+            t_hit = t;
+            return true;
+        }
+        if (t >= max_distance) return false;
+    }
+}
+
+static void checkRay(const Grid& grid, const glm::vec3& o, const glm::vec3& d,
+    float max_distance, const char* what)
+{
+    // t is in units of |d|, so march a fixed world distance per step
+    const float step = 1e-3f / glm::length(d);
+    float t_ref = 0.0f;
+    bool ref = marchRay(grid, o, d, max_distance, step, t_ref);
+
+    glm::vec3 hit;
+    float t = 0.0f;
+    bool got = grid.field.raycast(o, d, max_distance, hit, t);
+
+    bool ok = got == ref && (!got || std::abs(t - t_ref) <= 2.0f * step);
+    if (!ok) {
+        std::printf("  %s: o=(%g, %g, %g) d=(%g, %g, %g) raycast=%d t=%g march=%d t=%g\n",
+            what, o.x, o.y, o.z, d.x, d.y, d.z, got, t, ref, t_ref);
+    }
+    expect(ok, what);
+}
+
+int main() {
+    const int width = 17, height = 13;
+    Mesh mesh = makeGrid(width, height);
+    HeightField field(mesh, width, height);
+    Grid grid{ field,
+        mesh.vertices.front().x, mesh.vertices.back().x,
+        mesh.vertices.front().z, mesh.vertices.back().z };
+
+    // min / max match the vertices
+    float lo = mesh.vertices[0].y, hi = mesh.vertices[0].y;
+    for (const auto& v : mesh.vertices) {
+        lo = std::min(lo, v.y);
+        hi = std::max(hi, v.y);
+    }
+    expect(field.minHeight() == lo && field.maxHeight() == hi, "min/max height");
+
+    // heightAt hits the vertices exactly and clamps outside the grid
+    expect(field.heightAt(mesh.vertices[20].x, mesh.vertices[20].z) == mesh.vertices[20].y, "heightAt at vertex");
+    expect(field.heightAt(grid.x_min - 50.0f, grid.z_min) == mesh.vertices[0].y, "heightAt clamped");
+    expect(field.heightAt(NAN, NAN) == mesh.vertices[0].y, "heightAt NaN");
+
+    std::vector<glm::vec2> points{ { 0.3f, -1.7f }, { NAN, 2.0f }, { 100.0f, 100.0f } };
+    std::vector<float> heights;
+    field.heightsAt(points, heights);
+    expect(heights.size() == 3 && heights[0] == field.heightAt(0.3f, -1.7f)
+        && heights[2] == mesh.vertices.back().y, "heightsAt");
+
+    // normals agree with finite differences of heightAt, and are flat
+    // along clamped axes
+    glm::vec3 n = field.normalAt(0.37f, 1.21f);
+    const float h = 1e-3f;
+    float dx = (field.heightAt(0.37f + h, 1.21f) - field.heightAt(0.37f - h, 1.21f)) / (2 * h);
+    float dz = (field.heightAt(0.37f, 1.21f + h) - field.heightAt(0.37f, 1.21f - h)) / (2 * h);
+    expect(std::abs(n.x / n.y + dx) < 1e-2f && std::abs(n.z / n.y + dz) < 1e-2f, "normalAt slope");
+    expect(field.normalAt(grid.x_max + 10.0f, 0.5f).x == 0.0f, "normalAt clamped x");
+    expect(field.normalAt(0.5f, grid.z_min - 10.0f).z == 0.0f, "normalAt clamped z");
+
+    // under-surface cases
+    glm::vec3 on_surface(1.3f, field.heightAt(1.3f, -2.6f), -2.6f);
+    checkRay(grid, on_surface, glm::vec3(0.0f, -1.0f, 0.0f), 50.0f, "start on surface, down");
+    checkRay(grid, on_surface - glm::vec3(0, 1e-3f, 0), glm::vec3(0.0f, -1.0f, 0.0f), 50.0f, "start under surface, down");
+    checkRay(grid, glm::vec3(0.5f, lo - 5.0f, 0.5f), glm::vec3(0.0f, 1.0f, 0.0f), 50.0f, "start under terrain, up");
+    checkRay(grid, glm::vec3(grid.x_min - 5.0f, lo - 0.5f, 0.25f), glm::vec3(1.0f, 0.1f, 0.0f), 50.0f, "enter border under edge");
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> across(-15.0f, 15.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> above(hi + 0.5f, hi + 10.0f);
+    std::uniform_real_distribution<float> anywhere(lo - 3.0f, hi + 3.0f);
+
+    // vertical rays, including ones through vertices and grid lines
+    for (int i = 0; i < 200; ++i) {
+        float x = (i % 3 == 0) ? std::round(across(rng)) : across(rng);
+        float z = (i % 5 == 0) ? std::round(across(rng)) : across(rng);
+        checkRay(grid, glm::vec3(x, above(rng), z), glm::vec3(0.0f, -1.0f, 0.0f), 40.0f, "vertical ray");
+    }
+
+    // rays running along grid lines
+    for (int i = 0; i < 200; ++i) {
+        float x = std::round(across(rng));
+        float z = std::round(across(rng));
+        glm::vec3 d = (i % 2) ? glm::vec3(0.0f, -0.3f, unit(rng) < 0 ? -1.0f : 1.0f)
+                              : glm::vec3(unit(rng) < 0 ? -1.0f : 1.0f, -0.3f, 0.0f);
+        checkRay(grid, glm::vec3(x, above(rng), z), glm::normalize(d), 40.0f, "grid line ray");
+    }
+
+    // random rays from above, and from anywhere (including under the terrain)
+    for (int i = 0; i < 1000; ++i) {
+        glm::vec3 d = glm::normalize(glm::vec3(unit(rng), -std::abs(unit(rng)) - 0.05f, unit(rng)));
+        checkRay(grid, glm::vec3(across(rng), above(rng), across(rng)), d, 40.0f, "random ray from above");
+    }
+    for (int i = 0; i < 1000; ++i) {
+        glm::vec3 d = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)));
+        checkRay(grid, glm::vec3(across(rng), anywhere(rng), across(rng)), d, 40.0f, "random ray");
+    }
+
+    // t is measured in units of |dir|, so scaled directions must give the
+    // same hits as unit ones
+    for (float scale : { 1e-5f, 1e3f }) {
+        for (int i = 0; i < 300; ++i) {
+            glm::vec3 d = glm::normalize(glm::vec3(unit(rng), -std::abs(unit(rng)) - 0.05f, unit(rng)));
+            checkRay(grid, glm::vec3(across(rng), above(rng), across(rng)), d * scale, 40.0f / scale, "scaled ray from above");
+        }
+        for (int i = 0; i < 300; ++i) {
+            glm::vec3 d = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)));
+            checkRay(grid, glm::vec3(across(rng), anywhere(rng), across(rng)), d * scale, 40.0f / scale, "scaled random ray");
+        }
+    }
+
+    // a zero direction never hits, even with an unbounded distance
+    {
+        glm::vec3 hit;
+        float t;
+        glm::vec3 o(0.5f, field.heightAt(0.5f, 0.5f) + 0.01f, 0.5f);
+        expect(!field.raycast(o, glm::vec3(0.0f, 0.0f, 0.0f), INFINITY, hit, t), "zero direction");
+    }
+
+    // throughput on a larger field, also checking threads agree with a
+    // single-threaded run
+    const int big = 1025;
+    Mesh big_mesh = makeGrid(big, big);
+    HeightField big_field(big_mesh, big, big);
+
+    const int ray_count = 1 << 20;
+    std::uniform_real_distribution<float> big_across(-500.0f, 500.0f);
+    std::vector<glm::vec3> origins(ray_count), dirs(ray_count);
+    for (int i = 0; i < ray_count; ++i) {
+        origins[i] = glm::vec3(big_across(rng), above(rng), big_across(rng));
+        dirs[i] = glm::normalize(glm::vec3(unit(rng), -std::abs(unit(rng)) - 0.05f, unit(rng)));
+    }
+
+    auto castRange = [&](std::vector<float>& out, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            glm::vec3 hit;
+            float t;
+            out[i] = big_field.raycast(origins[i], dirs[i], 2000.0f, hit, t) ? t : -1.0f;
+        }
+    };
+
+    std::vector<float> single(ray_count), threaded(ray_count);
+    auto start = std::chrono::steady_clock::now();
+    castRange(single, 0, ray_count);
+    double single_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int thread_count = (int)std::max(1u, std::thread::hardware_concurrency());
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int k = 0; k < thread_count; ++k)
+        threads.emplace_back(castRange, std::ref(threaded),
+            ray_count * k / thread_count, ray_count * (k + 1) / thread_count);
+    for (auto& th : threads) th.join();
+    double threaded_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    expect(single == threaded, "threaded raycasts match single-threaded");
+
+    std::printf("raycast: %.3f us/ray, %.1f M rays/s single-threaded, %.1f M rays/s on %d threads\n",
+        single_s * 1e6 / ray_count, ray_count / single_s * 1e-6, ray_count / threaded_s * 1e-6, thread_count);
+
+    if (failures) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}